@@ -22,6 +22,7 @@ SOURCES += \
 
 HEADERS += \
     campusmap.h \
+    distancekernel.h \
     mainwindow.h
 
 FORMS += \
@@ -4,8 +4,13 @@
 #include <QString>
 #include <QVector>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QPointF>
 #include <QQueue>
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
 #include <limits.h>
 #include <algorithm>
 #include <QStringList>
@@ -14,7 +19,14 @@
 #include <QVector>
 #include <cmath>
 #include <limits>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include "distancekernel.h"
 
+// 景点视图：由 LandmarkStore 按需组装，供界面等现有代码按值使用
 struct Landmark {
     QString name;     // 景点名称
     QString code;     // 景点代码
@@ -22,18 +34,299 @@ struct Landmark {
     QPointF position; // 景点位置
 };
 
+// 字符串驻留池：相同文本只保存一份，景点通过 id 引用
+class StringPool {
+public:
+    StringPool() {
+        intern(QString());  // id 0 固定为空串，新建景点的默认引用
+    }
+
+    int intern(const QString& text) {
+        int id = index.value(text, -1);
+        if (id != -1) {
+            return id;
+        }
+        id = strings.size();
+        strings.append(text);
+        index.insert(text, id);
+        return id;
+    }
+
+    const QString& at(int id) const {
+        return strings[id];
+    }
+
+    int size() const {
+        return strings.size();
+    }
+
+private:
+    QVector<QString> strings;    // id -> 文本
+    QHash<QString, int> index;   // 文本 -> id
+};
+
+// 景点存储（结构数组）：坐标是热数据，按 x[]/y[] 连续存放；
+// 名称、代码、简介是冷数据，驻留在字符串池中只保留 id
+class LandmarkStore {
+public:
+    void resize(int n) {
+        xs.resize(n);
+        ys.resize(n);
+        nameIds.resize(n);
+        codeIds.resize(n);
+        introIds.resize(n);
+    }
+
+    int size() const {
+        return xs.size();
+    }
+
+    void set(int index, const QString& name, const QString& code, const QString& intro, const QPointF& position) {
+        xs[index] = static_cast<float>(position.x());
+        ys[index] = static_cast<float>(position.y());
+        nameIds[index] = pool.intern(name);
+        codeIds[index] = pool.intern(code);
+        introIds[index] = pool.intern(intro);
+    }
+
+    // 组装单个景点的视图（按值返回）
+    Landmark operator[](int index) const {
+        return { name(index), code(index), intro(index), position(index) };
+    }
+
+    float x(int index) const { return xs[index]; }
+    float y(int index) const { return ys[index]; }
+    QPointF position(int index) const { return QPointF(xs[index], ys[index]); }
+
+    const QString& name(int index) const { return pool.at(nameIds[index]); }
+    const QString& code(int index) const { return pool.at(codeIds[index]); }
+    const QString& intro(int index) const { return pool.at(introIds[index]); }
 
+    // 连续坐标数组，供只读坐标的批量计算使用
+    const float* xData() const { return xs.constData(); }
+    const float* yData() const { return ys.constData(); }
+
+private:
+    QVector<float> xs;
+    QVector<float> ys;
+    QVector<int> nameIds;
+    QVector<int> codeIds;
+    QVector<int> introIds;
+    StringPool pool;
+};
+
+// 连通性索引：连通分量用并查集随 addPath 增量维护，可随时 O(1) 判断连通；
+// 分量成员表、关节点和双连通分量（块）按图版本惰性重建
+class ConnectivityIndex {
+public:
+    ConnectivityIndex() : built(false), builtVersion(0) {
+    }
+
+    void reset(int n) {
+        parent.resize(n);
+        sizes.resize(n);
+        for (int i = 0; i < n; ++i) {
+            parent[i] = i;
+            sizes[i] = 1;
+        }
+        built = false;
+    }
+
+    void link(int a, int b) {
+        a = component(a);
+        b = component(b);
+        if (a == b) {
+            return;
+        }
+        if (sizes[a] < sizes[b]) {
+            std::swap(a, b);
+        }
+        parent[b] = a;
+        sizes[a] += sizes[b];
+    }
+
+    // 分量代表元（路径减半压缩）
+    int component(int v) const {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+
+    bool connected(int a, int b) const {
+        return component(a) == component(b);
+    }
+
+    // 所有目标是否在同一连通分量中
+    bool allConnected(const QVector<int>& targets) const {
+        for (int i = 1; i < targets.size(); ++i) {
+            if (!connected(targets[0], targets[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 以下结构需先调用 refresh
+    void refresh(const QVector<QVector<int>>& adjacencyList, quint64 version) {
+        if (built && builtVersion == version) {
+            return;
+        }
+        buildMembers();
+        buildBlocks(adjacencyList);
+        built = true;
+        builtVersion = version;
+    }
+
+    // v 所在连通分量的全部景点（升序）
+    const QVector<int>& componentMembers(int v) const {
+        return members[memberSlot[component(v)]];
+    }
+
+    bool isArticulation(int v) const {
+        return articulation[v];
+    }
+
+    const QVector<QVector<int>>& blocks() const {
+        return blockVertices;
+    }
+
+    // 包含 v 的所有块（孤立景点不属于任何块）
+    const QVector<int>& blocksOf(int v) const {
+        return vertexBlocks[v];
+    }
+
+private:
+    void buildMembers() {
+        int n = parent.size();
+        members.clear();
+        memberSlot.resize(n);
+        for (int v = 0; v < n; ++v) {
+            if (component(v) == v) {
+                memberSlot[v] = members.size();
+                members.append(QVector<int>());
+            }
+        }
+        for (int v = 0; v < n; ++v) {
+            members[memberSlot[component(v)]].append(v);
+        }
+    }
+
+    // Hopcroft-Tarjan 求关节点与块，用显式栈迭代以免大图递归过深
+    void buildBlocks(const QVector<QVector<int>>& adjacencyList) {
+        struct Frame {
+            int v;
+            int parent;
+            int next;      // 下一个待检查的邻接下标
+            int children;  // DFS 树中的孩子数
+        };
+
+        int n = adjacencyList.size();
+        QVector<int> disc(n);
+        QVector<int> low(n);
+        QVector<int> stamp(n);
+        disc.fill(-1);
+        stamp.fill(-1);
+        articulation.fill(false, n);
+        blockVertices.clear();
+        vertexBlocks.clear();
+        vertexBlocks.resize(n);
+
+        QVector<Frame> stack;
+        QVector<QPair<int, int>> edges;
+        int timer = 0;
+
+        for (int root = 0; root < n; ++root) {
+            if (disc[root] != -1) {
+                continue;
+            }
+            disc[root] = low[root] = timer++;
+            stack.append({ root, -1, 0, 0 });
+
+            while (!stack.isEmpty()) {
+                Frame& f = stack.last();
+                const QVector<int>& adj = adjacencyList[f.v];
+                if (f.next < adj.size()) {
+                    int v = f.v;
+                    int w = adj[f.next++];
+                    if (w == v || w == f.parent) {
+                        continue;
+                    }
+                    if (disc[w] == -1) {
+                        ++f.children;
+                        edges.append(qMakePair(v, w));
+                        disc[w] = low[w] = timer++;
+                        stack.append({ w, v, 0, 0 });
+                    }
+                    else if (disc[w] < disc[v]) {
+                        edges.append(qMakePair(v, w));
+                        low[v] = std::min(low[v], disc[w]);
+                    }
+                    continue;
+                }
+
+                Frame done = f;
+                stack.removeLast();
+                if (stack.isEmpty()) {
+                    articulation[done.v] = done.children > 1;
+                    continue;
+                }
+
+                int u = stack.last().v;
+                low[u] = std::min(low[u], low[done.v]);
+                if (low[done.v] >= disc[u]) {
+                    // u 把 done.v 所在子树分隔开：弹出边直到 (u, done.v)，构成一个块
+                    if (stack.last().parent != -1) {
+                        articulation[u] = true;
+                    }
+                    int id = blockVertices.size();
+                    QVector<int> block;
+                    QPair<int, int> e;
+                    do {
+                        e = edges.last();
+                        edges.removeLast();
+                        for (int x : { e.first, e.second }) {
+                            if (stamp[x] != id) {
+                                stamp[x] = id;
+                                block.append(x);
+                                vertexBlocks[x].append(id);
+                            }
+                        }
+                    } while (e != qMakePair(u, done.v));
+                    blockVertices.append(block);
+                }
+            }
+        }
+    }
+
+    mutable QVector<int> parent;  // 并查集，查询时顺带压缩路径
+    QVector<int> sizes;
+
+    bool built;
+    quint64 builtVersion;
+    QVector<QVector<int>> members;
+    QVector<int> memberSlot;               // 代表元 -> members 下标
+    QVector<bool> articulation;
+    QVector<QVector<int>> blockVertices;   // 块 -> 景点
+    QVector<QVector<int>> vertexBlocks;    // 景点 -> 块
+};
 
 class CampusMap {
 public:
     QVector<QVector<int>> dist;
-    QVector<Landmark> landmarks;  // 存储景点信息
+    LandmarkStore landmarks;  // 存储景点信息（坐标与文本分离存放）
     QVector<QVector<int>> adjacencyMatrix;  // 存储路径矩阵（邻接矩阵）
+    QVector<QVector<int>> adjacencyList;    // 每个景点的相邻景点（长度仍从邻接矩阵读取）
+    quint64 version;  // 图版本号，景点或路径每次变化时递增，用于判断缓存是否失效
+    ConnectivityIndex connectivityIndex;    // 连通分量随 addPath 维护，块结构按版本惰性重建
 
     // 构造函数
-    CampusMap(int numLandmarks) {
+    CampusMap(int numLandmarks) : version(0) {
         landmarks.resize(numLandmarks);
+        connectivityIndex.reset(numLandmarks);
         adjacencyMatrix.resize(numLandmarks);  // 仅调整外部向量大小
+        adjacencyList.resize(numLandmarks);
 
         // 初始化 adjacencyMatrix 内部每个 QVector<int>
         for (int i = 0; i < numLandmarks; ++i) {
@@ -45,22 +338,39 @@ public:
     }
 
     void addLandmark(int index, const QString& name, const QString& code, const QString& intro, const QPointF& position) {
-        landmarks[index] = { name, code, intro, position };
+        landmarks.set(index, name, code, intro, position);
+        ++version;
     }
 
     void addPath(int from, int to, int length) {
+        if (adjacencyMatrix[from][to] == -1) {
+            adjacencyList[from].append(to);
+            if (from != to) {
+                adjacencyList[to].append(from);
+            }
+        }
         adjacencyMatrix[from][to] = length;
         adjacencyMatrix[to][from] = length;  // 假设是无向图
+        connectivityIndex.link(from, to);
+        ++version;
+    }
+
+    // 获取与当前图版本一致的连通性索引
+    const ConnectivityIndex& connectivity() {
+        connectivityIndex.refresh(adjacencyList, version);
+        return connectivityIndex;
     }
 
     // 随机生成路径，并使用实际的绝对距离
     void generateRandomPaths() {
+        QVector<float> row;
         // 随机生成路径
         for (int i = 0; i < landmarks.size(); ++i) {
+            // 一次算出景点 i 到所有景点的绝对距离（欧几里得距离）
+            distancesFrom(i, row);
             for (int j = i + 1; j < landmarks.size(); ++j) {
                 if (rand() % 2 == 0) {
-                    // 计算景点之间的绝对距离（欧几里得距离）
-                    int length = static_cast<int>(calculateDistance(i, j));
+                    int length = static_cast<int>(row[j]);
                     addPath(i, j, length);
                 }
             }
@@ -69,22 +379,35 @@ public:
 
     // 计算两景点之间的欧几里得距离
     float calculateDistance(int from, int to) const {
-        const QPointF& p1 = landmarks[from].position;
-        const QPointF& p2 = landmarks[to].position;
-        return std::sqrt(std::pow(p2.x() - p1.x(), 2) + std::pow(p2.y() - p1.y(), 2));
+        float dx = landmarks.x(to) - landmarks.x(from);
+        float dy = landmarks.y(to) - landmarks.y(from);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    // 计算景点 from 到所有景点的欧几里得距离（批量 SIMD）
+    void distancesFrom(int from, QVector<float>& out) const {
+        int n = landmarks.size();
+        out.resize(n);
+        DistanceKernel::oneToMany(landmarks.x(from), landmarks.y(from),
+                                  landmarks.xData(), landmarks.yData(), n, out.data());
+    }
+
+    // 获取所有景点之间的距离矩阵（扁平存储，dist[i * n + j]）
+    QVector<int> getDistanceMatrixFlat() const {
+        int n = landmarks.size();
+        QVector<int> flat(n * n);
+        DistanceKernel::symmetricMatrix(landmarks.xData(), landmarks.yData(), n, flat.data());
+        return flat;
     }
 
     // 获取所有景点之间的距离矩阵
     QVector<QVector<int>> getDistanceMatrix() {
         int n = landmarks.size();
-        QVector<QVector<int>> dist(n, QVector<int>(n, 0));
+        QVector<int> flat = getDistanceMatrixFlat();
+        QVector<QVector<int>> dist(n);
 
         for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < n; ++j) {
-                if (i != j) {
-                    dist[i][j] = static_cast<int>(calculateDistance(i, j));
-                }
-            }
+            dist[i] = QVector<int>(flat.constData() + i * n, flat.constData() + (i + 1) * n);
         }
 
         this->dist = dist;
@@ -99,6 +422,11 @@ public:
         int totalLength = 0;
         path.clear();
 
+        // 目标不在同一连通分量时无解
+        if (!connectivityIndex.allConnected(targets)) {
+            return INT_MAX;
+        }
+
         // 假设起点为第一个目标景点
         int current = targets[0];
         visited[0] = true;
@@ -139,6 +467,11 @@ public:
 
         QVector<int> fullTargets = targets;
 
+        // 目标不在同一连通分量时无需遍历排列
+        if (!connectivityIndex.allConnected(targets)) {
+            return INT_MAX;
+        }
+
         // 遍历所有排列
         do {
             int totalLength = 0;
@@ -177,6 +510,236 @@ public:
         return bestPathLength;  // 返回最短路径长度，若没有有效路径则为 INT_MAX
     }
 
+    // 按块分解的 TSP：路程按路径图上的最短路计算，目标须全部连通，否则返回 INT_MAX。
+    // 最短路不会穿出块，因此回路在关节点处拆成各块内的子回路，各块独立（并行）求解后
+    // 再在关节点处拼接；path 为从 targets[0] 出发依次经过的目标景点
+    int calculateTSPByBlocks(const QVector<int>& targets, QVector<int>& path) {
+        path.clear();
+        if (targets.isEmpty()) {
+            return 0;
+        }
+        if (!connectivityIndex.allConnected(targets)) {
+            return INT_MAX;
+        }
+
+        int start = targets[0];
+        QVector<bool> isTarget(landmarks.size(), false);
+        for (int t : targets) {
+            isTarget[t] = true;
+        }
+        if (std::count(targets.begin(), targets.end(), start) == targets.size()) {
+            path.append(start);
+            return 0;
+        }
+
+        const ConnectivityIndex& index = connectivity();
+        const QVector<QVector<int>>& blocks = index.blocks();
+        int numBlocks = blocks.size();
+
+        // 以 start 所在的块为根，广度优先建立块-关节点树
+        QVector<int> parentCut(numBlocks, -2);  // -2 表示不在树中，根块为 -1
+        QHash<int, QVector<int>> childBlocks;   // 关节点 -> 子块
+        QVector<int> order;
+        int root = index.blocksOf(start)[0];
+        parentCut[root] = -1;
+        order.append(root);
+        for (int i = 0; i < order.size(); ++i) {
+            int b = order[i];
+            for (int v : blocks[b]) {
+                if (!index.isArticulation(v) || v == parentCut[b]) {
+                    continue;
+                }
+                for (int c : index.blocksOf(v)) {
+                    if (parentCut[c] == -2) {
+                        parentCut[c] = v;
+                        childBlocks[v].append(c);
+                        order.append(c);
+                    }
+                }
+            }
+        }
+
+        // 自底向上确定各块需要经过的终点：块内目标、通往目标的关节点，以及入口
+        QVector<QVector<int>> terminals(numBlocks);
+        QHash<int, bool> cutNeeded;
+        for (int i = order.size() - 1; i >= 0; --i) {
+            int b = order[i];
+            QVector<int>& t = terminals[b];
+            int entry = parentCut[b] == -1 ? start : parentCut[b];
+            for (int v : blocks[b]) {
+                if (v != entry && (isTarget[v] || cutNeeded.value(v, false))) {
+                    t.append(v);
+                }
+            }
+            if (!t.isEmpty() || parentCut[b] == -1) {
+                t.prepend(entry);
+                if (parentCut[b] != -1) {
+                    cutNeeded[parentCut[b]] = true;
+                }
+            }
+        }
+
+        // 各块独立求解，终点数较多的块分给多个线程
+        QVector<int> jobs;
+        for (int b : order) {
+            if (terminals[b].size() > 1) {
+                jobs.append(b);
+            }
+        }
+        QVector<QVector<int>> blockTour(numBlocks);
+        QVector<int> blockLength(numBlocks, 0);
+        QVector<int>* tourOut = blockTour.data();
+        int* lengthOut = blockLength.data();
+        const QVector<QVector<int>>* terminalIn = &terminals;
+        const CampusMap& self = *this;
+        std::atomic<int> nextJob(0);
+        auto worker = [&]() {
+            for (int j = nextJob++; j < jobs.size(); j = nextJob++) {
+                int b = jobs.at(j);
+                lengthOut[b] = self.solveBlockTour(blocks[b], terminalIn->at(b), tourOut[b]);
+            }
+        };
+        int threadCount = std::min<int>(jobs.size(), std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::thread> threads;
+        for (int i = 1; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+
+        // 从根块开始拼接：遇到通往子块的关节点时先走完子块回路，再回到该关节点继续
+        struct Frame {
+            int block;
+            int pos;
+        };
+        QVector<int> sequence;
+        QVector<Frame> stack;
+        int totalLength = 0;
+        if (terminals[root].size() == 1) {
+            blockTour[root] = terminals[root];  // 根块只有起点，其余目标都在子块中
+        }
+        stack.append({ root, 0 });
+        while (!stack.isEmpty()) {
+            Frame& f = stack.last();
+            const QVector<int>& tour = blockTour[f.block];
+            if (f.pos == 0) {
+                totalLength += blockLength[f.block];
+            }
+            if (f.pos >= tour.size()) {
+                stack.removeLast();
+                continue;
+            }
+            int v = tour[f.pos++];
+            if (v == parentCut[f.block]) {
+                continue;  // 子块入口已由父块输出
+            }
+            sequence.append(v);
+            auto children = childBlocks.constFind(v);
+            if (children == childBlocks.constEnd()) {
+                continue;
+            }
+            for (int i = children.value().size() - 1; i >= 0; --i) {
+                int c = children.value()[i];
+                if (terminals[c].size() > 1) {
+                    stack.append({ c, 0 });
+                }
+            }
+        }
+
+        QVector<bool> emitted(landmarks.size(), false);
+        for (int v : sequence) {
+            if (isTarget[v] && !emitted[v]) {
+                emitted[v] = true;
+                path.append(v);
+            }
+        }
+        return totalLength;
+    }
+
+    // 求块内经过所有终点的最短回路，tour 从 terminals[0] 出发；只读访问，可在多线程中调用
+    int solveBlockTour(const QVector<int>& block, const QVector<int>& terminals, QVector<int>& tour) const {
+        int k = terminals.size();
+
+        // 块内单源最短路（块内景点间的最短路不会离开块）
+        QHash<int, int> local;
+        for (int i = 0; i < block.size(); ++i) {
+            local.insert(block[i], i);
+        }
+        QVector<QVector<int>> d(k, QVector<int>(k, 0));
+        typedef QPair<int, int> Entry;
+        for (int a = 0; a < k; ++a) {
+            QVector<int> dist(block.size(), INT_MAX);
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+            dist[local.value(terminals[a])] = 0;
+            heap.push(qMakePair(0, terminals[a]));
+            while (!heap.empty()) {
+                Entry top = heap.top();
+                heap.pop();
+                int u = top.second;
+                if (top.first > dist[local.value(u)]) {
+                    continue;
+                }
+                for (int v : adjacencyList[u]) {
+                    int lv = local.value(v, -1);
+                    int nd = top.first + adjacencyMatrix[u][v];
+                    if (lv != -1 && nd < dist[lv]) {
+                        dist[lv] = nd;
+                        heap.push(qMakePair(nd, v));
+                    }
+                }
+            }
+            for (int b = 0; b < k; ++b) {
+                d[a][b] = dist[local.value(terminals[b])];
+            }
+        }
+
+        // 终点较少时枚举全部排列，否则用最近邻贪心
+        QVector<int> best(k);
+        for (int i = 0; i < k; ++i) {
+            best[i] = i;
+        }
+        int bestLength = INT_MAX;
+        if (k <= 9) {
+            QVector<int> perm = best;
+            do {
+                int length = d[perm[k - 1]][perm[0]];
+                for (int i = 0; i + 1 < k; ++i) {
+                    length += d[perm[i]][perm[i + 1]];
+                }
+                if (length < bestLength) {
+                    bestLength = length;
+                    best = perm;
+                }
+            } while (std::next_permutation(perm.begin() + 1, perm.end()));
+        }
+        else {
+            QVector<bool> visited(k, false);
+            visited[0] = true;
+            bestLength = 0;
+            for (int i = 1; i < k; ++i) {
+                int current = best[i - 1];
+                int next = -1;
+                for (int j = 0; j < k; ++j) {
+                    if (!visited[j] && (next == -1 || d[current][j] < d[current][next])) {
+                        next = j;
+                    }
+                }
+                visited[next] = true;
+                best[i] = next;
+                bestLength += d[current][next];
+            }
+            bestLength += d[best[k - 1]][0];
+        }
+
+        tour.clear();
+        for (int i : best) {
+            tour.append(terminals[i]);
+        }
+        return bestLength;
+    }
+
 
 
 };
@@ -190,13 +753,16 @@ public:
         QVector<int> prev(n, -1);  // 存储前驱节点
         QVector<bool> visited(n, false);  // 标记节点是否已访问
 
+        // 只在起点所在的连通分量内搜索
+        const QVector<int>& component = campus.connectivity().componentMembers(start);
+
         dist[start] = 0;
 
         // Dijkstra算法核心部分
-        for (int i = 0; i < n; ++i) {
+        for (int i = 0; i < component.size(); ++i) {
             int u = -1;
             // 找到未访问的最短距离的节点
-            for (int j = 0; j < n; ++j) {
+            for (int j : component) {
                 if (!visited[j] && (u == -1 || dist[j] < dist[u])) {
                     u = j;
                 }
@@ -207,8 +773,8 @@ public:
             visited[u] = true;
 
             // 遍历邻接节点，进行松弛操作
-            for (int v = 0; v < n; ++v) {
-                if (campus.adjacencyMatrix[u][v] != -1 && dist[u] + campus.adjacencyMatrix[u][v] < dist[v]) {
+            for (int v : campus.adjacencyList[u]) {
+                if (dist[u] + campus.adjacencyMatrix[u][v] < dist[v]) {
                     dist[v] = dist[u] + campus.adjacencyMatrix[u][v];
                     prev[v] = u;  // 更新前驱节点
                 }
@@ -241,6 +807,368 @@ public:
 
         return pathsWithLength;
     }
+
+    // 等时圈查询：从多个起点出发，路程不超过 budget 的所有景点及其最短距离（按距离升序）
+    // 使用二叉堆并只沿邻接表扩展，访问的节点只限于范围内及其边界
+    QVector<QPair<int, int>> findReachableWithin(const CampusMap& campus, const QVector<int>& sources, int budget) {
+        typedef QPair<int, int> Entry;  // (距离, 景点)
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+        QHash<int, int> dist;  // 只记录已触及的节点
+        QVector<QPair<int, int>> reachable;
+
+        if (budget < 0) {
+            return reachable;
+        }
+        for (int source : sources) {
+            if (!dist.contains(source)) {
+                dist.insert(source, 0);
+                heap.push(qMakePair(0, source));
+            }
+        }
+
+        while (!heap.empty()) {
+            Entry top = heap.top();
+            heap.pop();
+            int d = top.first;
+            int u = top.second;
+            if (d > dist.value(u)) {
+                continue;  // 过期的堆项
+            }
+            reachable.append(qMakePair(u, d));
+
+            for (int v : campus.adjacencyList[u]) {
+                int nd = d + campus.adjacencyMatrix[u][v];
+                if (nd > budget) {
+                    continue;
+                }
+                if (nd < dist.value(v, INT_MAX)) {
+                    dist.insert(v, nd);
+                    heap.push(qMakePair(nd, v));
+                }
+            }
+        }
+
+        return reachable;
+    }
+
+    QVector<QPair<int, int>> findReachableWithin(const CampusMap& campus, int source, int budget) {
+        return findReachableWithin(campus, QVector<int>{ source }, budget);
+    }
+
+    // k 条最短无环路径（Yen 算法）：按长度升序返回 (路径, 长度)，路径格式同 findShortestPathsWithLength。
+    // 先建一次到终点的反向最短路树：偏离搜索以其距离作 A* 启发，且树路径未被屏蔽时直接复用；
+    // 每条路径只从其偏离点之后再偏离（Lawler 改进），避免重复搜索。
+    // maxOverlap < 1 时启用多样性过滤：与已选路线重合长度占比超过 maxOverlap 的路线不返回
+    QVector<QPair<QVector<int>, int>> findKShortestPaths(CampusMap& campus, int source, int target, int k, double maxOverlap = 1.0) {
+        QVector<QPair<QVector<int>, int>> result;
+        if (k <= 0 || !campus.connectivityIndex.connected(source, target)) {
+            return result;
+        }
+        if (source == target) {
+            result.append(qMakePair(QVector<int>{ source }, 0));
+            return result;
+        }
+
+        int n = campus.landmarks.size();
+        QVector<int> next;
+        QVector<int> toTarget = distancesTo(campus, target, next);
+        QVector<int> blocked(n, -1);  // 记录被当前偏离屏蔽的根路径节点（按偏离编号标记）
+        int stamp = 0;
+
+        struct Candidate {
+            int length;
+            QVector<int> path;
+            int deviation;  // 与父路径开始不同的位置
+            bool operator>(const Candidate& other) const {
+                return length != other.length ? length > other.length : path > other.path;
+            }
+        };
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+        QSet<QVector<int>> seen;
+        QVector<QVector<int>> found;  // 已出队的全部路径（含被多样性过滤掉的）
+        int maxFound = maxOverlap < 1.0 ? 8 * k : k;
+
+        QVector<int> first;
+        for (int v = source; v != -1; v = next[v]) {
+            first.append(v);
+        }
+        candidates.push({ toTarget[source], first, 0 });
+        seen.insert(first);
+
+        while (!candidates.empty() && result.size() < k && found.size() < maxFound) {
+            Candidate current = candidates.top();
+            candidates.pop();
+            found.append(current.path);
+            if (isDiverse(campus, current.path, current.length, result, maxOverlap)) {
+                result.append(qMakePair(current.path, current.length));
+            }
+            if (result.size() == k) {
+                break;
+            }
+
+            const QVector<int>& path = current.path;
+            int rootLength = 0;
+            for (int i = 0; i < current.deviation; ++i) {
+                rootLength += campus.adjacencyMatrix[path[i]][path[i + 1]];
+            }
+            for (int i = current.deviation; i + 1 < path.size(); ++i) {
+                int spur = path[i];
+                ++stamp;
+                for (int j = 0; j < i; ++j) {
+                    blocked[path[j]] = stamp;
+                }
+
+                // 与当前根路径相同的已知路径，其下一条边不能再走
+                QVector<int> blockedNext;
+                for (const QVector<int>& p : found) {
+                    if (p.size() > i + 1 && std::equal(path.begin(), path.begin() + i + 1, p.begin())) {
+                        blockedNext.append(p[i + 1]);
+                    }
+                }
+
+                QVector<int> spurPath;
+                int spurLength = spurSearch(campus, spur, target, toTarget, next, blocked, stamp, blockedNext, spurPath);
+                if (spurLength != INT_MAX) {
+                    QVector<int> candidate = path.mid(0, i);
+                    candidate += spurPath;
+                    if (!seen.contains(candidate)) {
+                        seen.insert(candidate);
+                        candidates.push({ rootLength + spurLength, candidate, i });
+                    }
+                }
+                rootLength += campus.adjacencyMatrix[path[i]][path[i + 1]];
+            }
+        }
+
+        return result;
+    }
+
+private:
+    // 到 target 的最短距离（无向图即从 target 出发），next 为沿最短路走向 target 的下一跳
+    QVector<int> distancesTo(const CampusMap& campus, int target, QVector<int>& next) {
+        typedef QPair<int, int> Entry;
+        int n = campus.landmarks.size();
+        QVector<int> dist(n, INT_MAX);
+        next.fill(-1, n);
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+        dist[target] = 0;
+        heap.push(qMakePair(0, target));
+        while (!heap.empty()) {
+            Entry top = heap.top();
+            heap.pop();
+            int u = top.second;
+            if (top.first > dist[u]) {
+                continue;
+            }
+            for (int v : campus.adjacencyList[u]) {
+                int nd = top.first + campus.adjacencyMatrix[u][v];
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    next[v] = u;
+                    heap.push(qMakePair(nd, v));
+                }
+            }
+        }
+        return dist;
+    }
+
+    // 从 spur 到 target 的偏离搜索，避开被标记的节点和 spur 出发的 blockedNext 边。
+    // 反向最短路树上的路径未被屏蔽时直接取用，否则以 toTarget 为启发做 A*
+    int spurSearch(const CampusMap& campus, int spur, int target, const QVector<int>& toTarget, const QVector<int>& next,
+                   const QVector<int>& blocked, int stamp, const QVector<int>& blockedNext, QVector<int>& path) {
+        path.clear();
+        if (!blockedNext.contains(next[spur])) {
+            bool free = true;
+            for (int v = next[spur]; v != -1 && free; v = next[v]) {
+                free = blocked[v] != stamp;
+            }
+            if (free) {
+                for (int v = spur; v != -1; v = next[v]) {
+                    path.append(v);
+                }
+                return toTarget[spur];
+            }
+        }
+
+        typedef QPair<int, int> Entry;  // (g + h, 景点)
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+        QHash<int, int> g;
+        QHash<int, int> prev;
+        g.insert(spur, 0);
+        heap.push(qMakePair(toTarget[spur], spur));
+        while (!heap.empty()) {
+            Entry top = heap.top();
+            heap.pop();
+            int u = top.second;
+            int gu = g.value(u);
+            if (top.first > gu + toTarget[u]) {
+                continue;  // 过期的堆项
+            }
+            if (u == target) {
+                for (int v = target; v != spur; v = prev.value(v)) {
+                    path.prepend(v);
+                }
+                path.prepend(spur);
+                return gu;
+            }
+            for (int v : campus.adjacencyList[u]) {
+                if (blocked[v] == stamp || toTarget[v] == INT_MAX || (u == spur && blockedNext.contains(v))) {
+                    continue;
+                }
+                int nd = gu + campus.adjacencyMatrix[u][v];
+                if (nd < g.value(v, INT_MAX)) {
+                    g.insert(v, nd);
+                    prev.insert(v, u);
+                    heap.push(qMakePair(nd + toTarget[v], v));
+                }
+            }
+        }
+        return INT_MAX;
+    }
+
+    // 多样性过滤：与任一已选路线的重合边长度占本路线长度的比例超过 maxOverlap 时视为近似重复
+    bool isDiverse(const CampusMap& campus, const QVector<int>& path, int length,
+                   const QVector<QPair<QVector<int>, int>>& chosen, double maxOverlap) {
+        if (maxOverlap >= 1.0 || length <= 0) {
+            return true;
+        }
+        for (const auto& other : chosen) {
+            QSet<QPair<int, int>> edges;
+            for (int i = 0; i + 1 < other.first.size(); ++i) {
+                int a = other.first[i];
+                int b = other.first[i + 1];
+                edges.insert(qMakePair(std::min(a, b), std::max(a, b)));
+            }
+            int shared = 0;
+            for (int i = 0; i + 1 < path.size(); ++i) {
+                int a = path[i];
+                int b = path[i + 1];
+                if (edges.contains(qMakePair(std::min(a, b), std::max(a, b)))) {
+                    shared += campus.adjacencyMatrix[a][b];
+                }
+            }
+            if (shared > maxOverlap * length) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// 查询结果缓存：缓存单源最短路径树和多景点游览（TSP）结果
+// 键为图版本号加规范化（排序去重）后的目标集合；发现图版本变化时整体清空。
+// 线程安全；按估算的字节数限制内存，超出时由 QCache 淘汰最久未使用的项
+class RouteCache {
+public:
+    typedef QVector<QPair<QVector<int>, int>> PathTree;  // 与 findShortestPathsWithLength 的结果相同
+
+    struct Tour {
+        QVector<int> path;  // 游览顺序
+        int length;         // 总长度
+    };
+
+    struct Stats {
+        quint64 hits;
+        quint64 misses;
+        int entries;  // 当前缓存项数
+        int bytes;    // 当前估算占用字节数
+    };
+
+    // maxBytes 为总内存上限，最短路径树与游览结果各占一半
+    explicit RouteCache(int maxBytes = 8 * 1024 * 1024)
+        : trees(maxBytes / 2), tours(maxBytes / 2), graphVersion(0), hits(0), misses(0) {
+    }
+
+    bool findTree(quint64 version, int start, PathTree& out) {
+        QMutexLocker locker(&mutex);
+        syncVersion(version);
+        PathTree* tree = trees.object(qMakePair(version, start));
+        if (!tree) {
+            ++misses;
+            return false;
+        }
+        ++hits;
+        out = *tree;
+        return true;
+    }
+
+    void insertTree(quint64 version, int start, const PathTree& tree) {
+        int cost = 32;
+        for (const auto& entry : tree) {
+            cost += 32 + entry.first.size() * static_cast<int>(sizeof(int));
+        }
+        QMutexLocker locker(&mutex);
+        syncVersion(version);
+        trees.insert(qMakePair(version, start), new PathTree(tree), cost);
+    }
+
+    // 命中时返回的路径已旋转为从 targets[0] 出发
+    bool findTour(quint64 version, const QVector<int>& targets, Tour& out) {
+        QMutexLocker locker(&mutex);
+        syncVersion(version);
+        Tour* tour = tours.object(qMakePair(version, canonicalTargets(targets)));
+        if (!tour) {
+            ++misses;
+            return false;
+        }
+        ++hits;
+        out = *tour;
+        if (!targets.isEmpty()) {
+            startTourAt(out.path, targets[0]);
+        }
+        return true;
+    }
+
+    void insertTour(quint64 version, const QVector<int>& targets, const Tour& tour) {
+        QVector<int> key = canonicalTargets(targets);
+        int cost = 64 + (key.size() + tour.path.size()) * static_cast<int>(sizeof(int));
+        QMutexLocker locker(&mutex);
+        syncVersion(version);
+        tours.insert(qMakePair(version, key), new Tour(tour), cost);
+    }
+
+    Stats stats() const {
+        QMutexLocker locker(&mutex);
+        Stats s;
+        s.hits = hits;
+        s.misses = misses;
+        s.entries = trees.count() + tours.count();
+        s.bytes = trees.totalCost() + tours.totalCost();
+        return s;
+    }
+
+    // 目标集合的规范形式：排序并去重（游览是回路，与输入顺序无关）
+    static QVector<int> canonicalTargets(const QVector<int>& targets) {
+        QVector<int> key = targets;
+        std::sort(key.begin(), key.end());
+        key.erase(std::unique(key.begin(), key.end()), key.end());
+        return key;
+    }
+
+    // 将回路旋转为从 start 出发，总长度不变
+    static void startTourAt(QVector<int>& path, int start) {
+        auto it = std::find(path.begin(), path.end(), start);
+        if (it != path.end()) {
+            std::rotate(path.begin(), it, path.end());
+        }
+    }
+
+private:
+    // 图版本变化后旧结果全部失效，直接清空释放内存
+    void syncVersion(quint64 version) {
+        if (version != graphVersion) {
+            trees.clear();
+            tours.clear();
+            graphVersion = version;
+        }
+    }
+
+    mutable QMutex mutex;
+    QCache<QPair<quint64, int>, PathTree> trees;
+    QCache<QPair<quint64, QVector<int>>, Tour> tours;
+    quint64 graphVersion;
+    quint64 hits;
+    quint64 misses;
 };
 
 #endif // CAMPUSMAP_H
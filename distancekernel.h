@@ -0,0 +1,117 @@
+﻿#ifndef DISTANCEKERNEL_H
+#define DISTANCEKERNEL_H
+
+#include <algorithm>
+#include <cmath>
+
+// 按编译目标选择指令集：AVX2 > SSE2 > 标量
+#if defined(__AVX2__)
+#define DISTANCEKERNEL_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DISTANCEKERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+// 批量欧几里得距离计算，输入为连续的 x[]/y[] 坐标数组（见 LandmarkStore）
+// 各路径与标量 std::sqrt(dx * dx + dy * dy) 的结果逐位一致，整数结果按 static_cast<int> 截断
+class DistanceKernel {
+public:
+    enum { TileSize = 64 };  // 矩阵分块边长，一块输出约 16KB
+
+    // 一对多：out[j] = |(px, py) - (xs[j], ys[j])|
+    static void oneToMany(float px, float py, const float* xs, const float* ys, int n, float* out) {
+        int j = 0;
+#if defined(DISTANCEKERNEL_AVX2)
+        const __m256 vx = _mm256_set1_ps(px);
+        const __m256 vy = _mm256_set1_ps(py);
+        for (; j + 8 <= n; j += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + j), vx);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + j), vy);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            _mm256_storeu_ps(out + j, _mm256_sqrt_ps(d2));
+        }
+#elif defined(DISTANCEKERNEL_SSE2)
+        const __m128 vx = _mm_set1_ps(px);
+        const __m128 vy = _mm_set1_ps(py);
+        for (; j + 4 <= n; j += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + j), vx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + j), vy);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            _mm_storeu_ps(out + j, _mm_sqrt_ps(d2));
+        }
+#endif
+        for (; j < n; ++j) {
+            float dx = xs[j] - px;
+            float dy = ys[j] - py;
+            out[j] = std::sqrt(dx * dx + dy * dy);
+        }
+    }
+
+    // 一对多，结果截断为整数（与路径长度的取整方式相同）
+    static void oneToManyInt(float px, float py, const float* xs, const float* ys, int n, int* out) {
+        int j = 0;
+#if defined(DISTANCEKERNEL_AVX2)
+        const __m256 vx = _mm256_set1_ps(px);
+        const __m256 vy = _mm256_set1_ps(py);
+        for (; j + 8 <= n; j += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + j), vx);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + j), vy);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j), _mm256_cvttps_epi32(_mm256_sqrt_ps(d2)));
+        }
+#elif defined(DISTANCEKERNEL_SSE2)
+        const __m128 vx = _mm_set1_ps(px);
+        const __m128 vy = _mm_set1_ps(py);
+        for (; j + 4 <= n; j += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + j), vx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + j), vy);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j), _mm_cvttps_epi32(_mm_sqrt_ps(d2)));
+        }
+#endif
+        for (; j < n; ++j) {
+            float dx = xs[j] - px;
+            float dy = ys[j] - py;
+            out[j] = static_cast<int>(std::sqrt(dx * dx + dy * dy));
+        }
+    }
+
+    // 多对多：out 为 m 行 n 列（行主序），out[i * n + j] = |src[i] - dst[j]|
+    static void manyToMany(const float* srcX, const float* srcY, int m,
+                           const float* xs, const float* ys, int n, int* out) {
+        for (int j0 = 0; j0 < n; j0 += TileSize) {
+            int cols = std::min<int>(TileSize, n - j0);
+            for (int i = 0; i < m; ++i) {
+                oneToManyInt(srcX[i], srcY[i], xs + j0, ys + j0, cols, out + static_cast<long long>(i) * n + j0);
+            }
+        }
+    }
+
+    // 对称距离矩阵：out 为 n*n（行主序）。只计算上三角的块，
+    // 每块先写入栈上缓冲，再按行连续写出本块及其转置块
+    static void symmetricMatrix(const float* xs, const float* ys, int n, int* out) {
+        int tile[TileSize][TileSize];
+        for (int i0 = 0; i0 < n; i0 += TileSize) {
+            int rows = std::min<int>(TileSize, n - i0);
+            for (int j0 = i0; j0 < n; j0 += TileSize) {
+                int cols = std::min<int>(TileSize, n - j0);
+                for (int r = 0; r < rows; ++r) {
+                    oneToManyInt(xs[i0 + r], ys[i0 + r], xs + j0, ys + j0, cols, tile[r]);
+                    std::copy(tile[r], tile[r] + cols, out + static_cast<long long>(i0 + r) * n + j0);
+                }
+                if (j0 == i0) {
+                    continue;  // 对角块本身已对称
+                }
+                for (int c = 0; c < cols; ++c) {
+                    int* mirror = out + static_cast<long long>(j0 + c) * n + i0;
+                    for (int r = 0; r < rows; ++r) {
+                        mirror[r] = tile[r][c];
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif // DISTANCEKERNEL_H
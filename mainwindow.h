@@ -107,6 +107,7 @@ public:
     QGraphicsScene* scene;
     QLabel* infoLabel;
     Dijkstra dijkstra;
+    RouteCache routeCache;  // 重复查询的结果缓存
     QLineEdit* sourceLineEdit; // 输入框
 
     QVector<QPair<int, int>> paths;  // 存储路径的索引对
@@ -184,12 +185,14 @@ public:
 
 
     void generateRandomPaths() {
+        QVector<float> row;
         // 随机生成路径
         for (int i = 0; i < 10; ++i) {
+            // 一次算出景点 i 到所有景点的绝对距离（欧几里得距离）
+            campusMap->distancesFrom(i, row);
             for (int j = i + 1; j < 10; ++j) {
                 if (rand() % 2 == 0) {
-                    // 计算景点之间的绝对距离（欧几里得距离）
-                    int length = static_cast<int>(campusMap->calculateDistance(i, j));
+                    int length = static_cast<int>(row[j]);
                     campusMap->addPath(i, j, length);
                     addPath(i, j, length);
                 }
@@ -203,8 +206,8 @@ public:
         pathLengths[qMakePair(startIndex, endIndex)] = length;
 
         // 获取景点位置
-        QPointF startPos = campusMap->landmarks[startIndex].position;
-        QPointF endPos = campusMap->landmarks[endIndex].position;
+        QPointF startPos = campusMap->landmarks.position(startIndex);
+        QPointF endPos = campusMap->landmarks.position(endIndex);
 
         // 绘制直线连接两个景点
         QGraphicsLineItem* line = new QGraphicsLineItem(QLineF(startPos, endPos));
@@ -225,8 +228,12 @@ public:
         // 将起点转换为整数
         int startIdx = start.toInt();
 
-        // 查询最短路径和路径长度
-        QVector<QPair<QVector<int>, int>> pathsWithLength = dijkstra.findShortestPathsWithLength(*campusMap, startIdx);
+        // 查询最短路径和路径长度（优先使用缓存）
+        QVector<QPair<QVector<int>, int>> pathsWithLength;
+        if (!routeCache.findTree(campusMap->version, startIdx, pathsWithLength)) {
+            pathsWithLength = dijkstra.findShortestPathsWithLength(*campusMap, startIdx);
+            routeCache.insertTree(campusMap->version, startIdx, pathsWithLength);
+        }
 
         QString result = QString::fromLocal8Bit("从景点") + start + QString::fromLocal8Bit("到其他景点的最短路径及其长度：\n");
 
@@ -275,20 +282,33 @@ public:
             targets.append(target.toInt());
         }
 
-     
-        // 获取距离矩阵
-        QVector<QVector<int>> dist = campusMap->getDistanceMatrix();
-        printf("距离矩阵：\n");
-        for (const auto& row : dist) {
-            for (int val : row) {
-                printf("%d ", val);
+        // 相同目标集合的游览结果直接取缓存
+        RouteCache::Tour tour;
+        if (!routeCache.findTour(campusMap->version, targets, tour)) {
+            // 获取距离矩阵
+            QVector<QVector<int>> dist = campusMap->getDistanceMatrix();
+            printf("距离矩阵：\n");
+            for (const auto& row : dist) {
+                for (int val : row) {
+                    printf("%d ", val);
+                }
+                printf("\n");
             }
-            printf("\n");
+
+            // 使用距离矩阵进行 TSP 计算（在规范化的目标集合上计算，保证遍历全部排列）
+            QVector<int> canonical = RouteCache::canonicalTargets(targets);
+            tour.length = campusMap->calculateTSPUsingMatrix(canonical, tour.path);
+            routeCache.insertTour(campusMap->version, targets, tour);
+            RouteCache::startTourAt(tour.path, targets[0]);
         }
+        QVector<int> path = tour.path;
+        int shortestPath = tour.length;
 
-        // 使用距离矩阵进行 TSP 计算
-        QVector<int> path;
-        int shortestPath = campusMap->calculateTSPUsingMatrix(targets, path);
+        // 目标之间不连通，直接提示
+        if (shortestPath == INT_MAX) {
+            infoLabel->setText(QString::fromLocal8Bit("所选景点之间没有路径连通，无法规划游览路线"));
+            return;
+        }
 
         // 输出最短路径和路径长度
         printf("最短路径长度: %d\n", shortestPath);
@@ -297,6 +317,10 @@ public:
             printf("%d ", idx);
         }
 
+        RouteCache::Stats stats = routeCache.stats();
+        printf("\n缓存命中: %llu, 未命中: %llu, 缓存项: %d, 占用字节: %d\n",
+               stats.hits, stats.misses, stats.entries, stats.bytes);
+
    
         // 输出计算结果
         QString result = QString::fromLocal8Bit("从景点") + QString::number(targets[0]) + QString::fromLocal8Bit("到各目标景点的最短路径：\n");